@@ -3,6 +3,13 @@
 #include <sys/time.h>
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <unistd.h>
 
 static const int TERM_CRITERION = 1;
 
@@ -82,6 +89,76 @@ struct HashElement {
 };
 struct HashElement hashTable[HASHSIZE];
 
+// Live search instrumentation. The counters are only compiled in if SEARCH_STATS is defined, otherwise all
+// STAT_*-macros below expand to nothing and the solver runs exactly as before. Every search thread owns one
+// set of counters, which only this thread writes to. A separate reporter thread samples all sets periodically
+// and prints the totals as one JSON line to stderr (stdout still only contains the solution).
+#ifdef SEARCH_STATS
+
+// Seconds between two reports of the reporter thread
+#define STATS_INTERVAL 10
+
+// Maximum number of search threads that can register their own set of counters
+#define STATS_MAXTHREADS 64
+
+// Upper bound for peg counts
+#define STATS_MAXPEGS 64
+
+// Upper bound for the number of symmetric images probed per position
+#define STATS_MAXSYMMETRIES 8
+
+// Number of plies below the root that are tracked to compute the progress of the search
+#define STATS_PLIES 8
+
+struct SearchStats {
+    uint64_t nodesPerPegs[STATS_MAXPEGS];       // calls of backtrack(), split by the number of pegs on the board
+    uint64_t misses;                            // table lookups that found none of the symmetric images
+    uint64_t hits[STATS_MAXSYMMETRIES];         // table hits, split by the symmetric image that was found
+    uint64_t collisions;                        // lookups that found a different position in the entry
+    uint64_t overwrites;                        // stores that replaced a different position
+    int64_t occupancy[STATS_MAXPEGS];           // change of the number of table entries per number of pegs
+    uint64_t rootPegs;                          // number of pegs of the root position of this thread
+    uint64_t plyMoves[STATS_PLIES];             // moves of the position on each ply of the current path (0 = none)
+    uint64_t plyStarted[STATS_PLIES];           // number of these moves whose subtree was entered
+} __attribute__((aligned(64)));
+
+static struct SearchStats statsSlots[STATS_MAXTHREADS];
+static int statsNumThreads = 0;
+static __thread struct SearchStats *threadStats = NULL;
+
+static pthread_t statsReporter;
+static int statsRunning = 0;
+
+// A counter is only written by its owning thread, so a plain read-modify-write is sufficient. The atomic
+// store (and load in the reporter) only prevents torn or cached values, it does not emit a locked instruction.
+#define STAT_ADD(field, n) __atomic_store_n(&threadStats->field, threadStats->field + (n), __ATOMIC_RELAXED)
+#define STAT_SET(field, n) __atomic_store_n(&threadStats->field, (n), __ATOMIC_RELAXED)
+#define STAT_READ(s, field) __atomic_load_n(&(s)->field, __ATOMIC_RELAXED)
+
+#define STAT_NODE(pegs) statsNode(pegs)
+#define STAT_MISS() STAT_ADD(misses, 1)
+#define STAT_HIT(i) STAT_ADD(hits[i], 1)
+#define STAT_COLLISION() STAT_ADD(collisions, 1)
+#define STAT_STORE(oldKey, newKey) statsStore(oldKey, newKey)
+#define STAT_EXPAND(pegs, allmv) statsExpand(pegs, allmv)
+#define STATS_REGISTER(b) statsRegister(b)
+#define STATS_START() statsStart()
+#define STATS_STOP() statsStop()
+
+#else
+
+#define STAT_NODE(pegs) do {} while (0)
+#define STAT_MISS() do {} while (0)
+#define STAT_HIT(i) do {} while (0)
+#define STAT_COLLISION() do {} while (0)
+#define STAT_STORE(oldKey, newKey) do {} while (0)
+#define STAT_EXPAND(pegs, allmv) do {} while (0)
+#define STATS_REGISTER(b) do {} while (0)
+#define STATS_START() do {} while (0)
+#define STATS_STOP() do {} while (0)
+
+#endif
+
 /*
  * Modulo operator, since the %-operator is the remainder and cannot deal with negative integers
  */
@@ -118,6 +195,17 @@ int bitCount(uint64_t x) {
     return c;
 }
 
+/*
+ * Count the one-bits with a constant number of operations. Used by the statistics on every node, where the loop
+ * of bitCount() (or a library call for __builtin_popcountll without -mpopcnt) would be too slow.
+ */
+static inline int popCount(uint64_t x) {
+    x = x - ((x >> 1) & UINT64_C(0x5555555555555555));
+    x = (x & UINT64_C(0x3333333333333333)) + ((x >> 2) & UINT64_C(0x3333333333333333));
+    x = (x + (x >> 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+    return (int) ((x * UINT64_C(0x0101010101010101)) >> 56);
+}
+
 /*
  * Rotatate 64-bit variable x by y bits. Note that this is not a shift-operation but a real
  * rotate-left
@@ -127,6 +215,15 @@ static inline uint64_t rol(uint64_t x, unsigned int y) {
     return x;
 }
 
+/*
+ * Current wall-clock time in seconds
+ */
+double wallTime() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+}
+
 /*
  * Compute the bit indexes of the board from top to bottom (left to right in the rows) and from left to
  * right (from top to bottom in each column)
@@ -225,6 +322,196 @@ uint64_t setPeg(uint64_t b, int bit) {
     return b | (1UL << bit);
 }
 
+#ifdef SEARCH_STATS
+
+/*
+ * Assign a set of counters to the calling search thread. Has to be called once by every thread that
+ * searches, before it starts. The number of pegs of the root position b gives the ply of each node.
+ */
+void statsRegister(uint64_t b) {
+    int slot = __atomic_fetch_add(&statsNumThreads, 1, __ATOMIC_RELAXED);
+    if (slot >= STATS_MAXTHREADS) {
+        fprintf(stderr, "Too many search threads for the statistics (max. %d)\n", STATS_MAXTHREADS);
+        exit(1);
+    }
+    threadStats = &statsSlots[slot];
+    STAT_SET(rootPegs, (uint64_t) bitCount(b));
+}
+
+/*
+ * Count a node with pegs pegs. On the first plies, one more move of its parent is started, and the node itself
+ * has no moves yet.
+ */
+static inline void statsNode(int pegs) {
+    STAT_ADD(nodesPerPegs[pegs], 1);
+    uint64_t ply = threadStats->rootPegs - (uint64_t) pegs;
+    if (ply < STATS_PLIES) {
+        if (ply > 0)
+            STAT_ADD(plyStarted[ply - 1], 1);
+        STAT_SET(plyMoves[ply], 0);
+    }
+}
+
+/*
+ * A node with pegs pegs has the moves allmv and searches them now
+ */
+static inline void statsExpand(int pegs, const uint64_t *const allmv) {
+    uint64_t ply = threadStats->rootPegs - (uint64_t) pegs;
+    if (ply >= STATS_PLIES)
+        return;
+    uint64_t moves = 0;
+    for (int i = 0; i < 8; i++)
+        moves += popCount(allmv[i]);
+    STAT_SET(plyStarted[ply], 0);
+    STAT_SET(plyMoves[ply], moves);
+}
+
+/*
+ * Fraction of the tree of a thread that is searched, as mixed-radix number over the plies of the current path:
+ * every move that is finished on ply d counts 1 / (moves on ply 0 * ... * moves on ply d). The move that is
+ * searched at the moment does not count, also if it finishes the search with a solution.
+ */
+double statsProgress(struct SearchStats *s) {
+    double progress = 0.0, width = 1.0;
+    for (int d = 0; d < STATS_PLIES; d++) {
+        uint64_t moves = STAT_READ(s, plyMoves[d]);
+        uint64_t started = STAT_READ(s, plyStarted[d]);
+        if (moves == 0 || started == 0)
+            break;
+        if (started > moves) // the counters of this ply were reset while reading them
+            break;
+        width /= (double) moves;
+        progress += (double) (started - 1) * width;
+    }
+    return progress;
+}
+
+/*
+ * Keep the occupancy histogram of the transposition table up to date when an entry is written. The entries
+ * are counted by the number of pegs of their position, which shows the depths that fill the table.
+ */
+static inline void statsStore(uint64_t oldKey, uint64_t newKey) {
+    if (oldKey != ZERO) {
+        if (oldKey != newKey)
+            STAT_ADD(overwrites, 1);
+        STAT_ADD(occupancy[popCount(oldKey)], -1);
+    }
+    STAT_ADD(occupancy[popCount(newKey)], 1);
+}
+
+/*
+ * Number of nodes of the thread with the counters s. Only the nodes per number of pegs are counted, to save
+ * one counter per node.
+ */
+uint64_t statsNodes(struct SearchStats *s) {
+    uint64_t nodes = 0;
+    for (int i = 0; i < STATS_MAXPEGS; i++)
+        nodes += STAT_READ(s, nodesPerPegs[i]);
+    return nodes;
+}
+
+/*
+ * Sum up the counters of all threads and print them as one JSON line to stderr
+ */
+void statsPrint(double elapsed, double nodesPerSec, int finished) {
+    struct SearchStats sum = {0};
+    double progress = 0.0;
+    int progressThreads = 0;
+    int numThreads = __atomic_load_n(&statsNumThreads, __ATOMIC_RELAXED);
+    if (numThreads > STATS_MAXTHREADS)
+        numThreads = STATS_MAXTHREADS;
+
+    for (int t = 0; t < numThreads; t++) {
+        struct SearchStats *s = &statsSlots[t];
+        sum.misses += STAT_READ(s, misses);
+        sum.collisions += STAT_READ(s, collisions);
+        sum.overwrites += STAT_READ(s, overwrites);
+        for (int i = 0; i < STATS_MAXPEGS; i++) {
+            sum.nodesPerPegs[i] += STAT_READ(s, nodesPerPegs[i]);
+            sum.occupancy[i] += STAT_READ(s, occupancy[i]);
+        }
+        for (int i = 0; i < NUMSYMMETRIES; i++)
+            sum.hits[i] += STAT_READ(s, hits[i]);
+        // only threads that run a depth-first search from their root report a progress
+        if (STAT_READ(s, plyMoves[0]) != 0) {
+            progress += statsProgress(s);
+            progressThreads++;
+        }
+    }
+    if (progressThreads > 0)
+        progress /= progressThreads;
+
+    int64_t entries = 0;
+    uint64_t nodes = 0;
+    for (int i = 0; i < STATS_MAXPEGS; i++) {
+        entries += sum.occupancy[i];
+        nodes += sum.nodesPerPegs[i];
+    }
+    // A hit of symmetric image i needs i + 1 table lookups, a miss needs one per symmetric image
+    uint64_t probes = sum.misses * NUMSYMMETRIES;
+    for (int i = 0; i < NUMSYMMETRIES; i++)
+        probes += sum.hits[i] * (i + 1);
+
+    fprintf(stderr, "{\"time\":%.1f,\"nodes\":%" PRIu64 ",\"nodesPerSec\":%.0f", elapsed, nodes, nodesPerSec);
+    fprintf(stderr, ",\"nodesPerPegs\":[");
+    for (int i = 0; i <= NUMBOARDBITS; i++)
+        fprintf(stderr, "%s%" PRIu64, i ? "," : "", sum.nodesPerPegs[i]);
+    fprintf(stderr, "],\"probes\":%" PRIu64 ",\"hits\":[", probes);
+    for (int i = 0; i < NUMSYMMETRIES; i++)
+        fprintf(stderr, "%s%" PRIu64, i ? "," : "", sum.hits[i]);
+    fprintf(stderr, "],\"collisions\":%" PRIu64 ",\"overwrites\":%" PRIu64, sum.collisions, sum.overwrites);
+    fprintf(stderr, ",\"entries\":%" PRId64 ",\"fill\":%.6f,\"occupancy\":[", entries,
+            (double) entries / HASHSIZE);
+    for (int i = 0; i <= NUMBOARDBITS; i++)
+        fprintf(stderr, "%s%" PRId64, i ? "," : "", sum.occupancy[i]);
+    fprintf(stderr, "],\"progress\":%.6g", progress);
+    // The ETA is the time until the whole tree is searched, if the rest of the tree is searched at the same
+    // rate as the part before. Later subtrees profit from the filled transposition table, so it tends to be too
+    // high early in the search (and the search stops earlier if it finds a solution).
+    if (finished)
+        fprintf(stderr, ",\"eta\":0}\n");
+    else if (progress > 0.0)
+        fprintf(stderr, ",\"eta\":%.0f}\n", elapsed * (1.0 - progress) / progress);
+    else
+        fprintf(stderr, ",\"eta\":null}\n");
+    fflush(stderr);
+}
+
+/*
+ * Reporter thread: samples the counters every STATS_INTERVAL seconds and once more when it is stopped
+ */
+void *statsReport(void *arg) {
+    double start = wallTime(), last = start;
+    uint64_t lastNodes = 0;
+    while (__atomic_load_n(&statsRunning, __ATOMIC_ACQUIRE)) {
+        for (int i = 0; i < 10 * STATS_INTERVAL && __atomic_load_n(&statsRunning, __ATOMIC_ACQUIRE); i++)
+            usleep(100000);
+
+        double now = wallTime();
+        uint64_t nodes = 0;
+        int numThreads = __atomic_load_n(&statsNumThreads, __ATOMIC_RELAXED);
+        for (int t = 0; t < numThreads && t < STATS_MAXTHREADS; t++)
+            nodes += statsNodes(&statsSlots[t]);
+        double nodesPerSec = now > last ? (double) (nodes - lastNodes) / (now - last) : 0.0;
+        statsPrint(now - start, nodesPerSec, !__atomic_load_n(&statsRunning, __ATOMIC_ACQUIRE));
+        last = now;
+        lastNodes = nodes;
+    }
+    return arg;
+}
+
+void statsStart() {
+    __atomic_store_n(&statsRunning, 1, __ATOMIC_RELEASE);
+    pthread_create(&statsReporter, NULL, statsReport, NULL);
+}
+
+void statsStop() {
+    __atomic_store_n(&statsRunning, 0, __ATOMIC_RELEASE);
+    pthread_join(statsReporter, NULL);
+}
+
+#endif
+
 
 /*
  * Function to compute the hash for a 64bit variable. Maybe Zobrist keys would work better (has to be investigated
@@ -290,9 +577,14 @@ int getTransposition(uint64_t b) {
     for (int i = 0; i < NUMSYMMETRIES; i++) {
         uint64_t hash = getHash(m[i]);
         int hashIndex = ((int) hash & HASHMASK);
-        if (hashTable[hashIndex].key == m[i])
+        if (hashTable[hashIndex].key == m[i]) {
+            STAT_HIT(i);
             return hashTable[hashIndex].value;
+        }
+        if (hashTable[hashIndex].key != ZERO)
+            STAT_COLLISION();
     }
+    STAT_MISS();
     return HASHMISS;
 }
 
@@ -302,6 +594,7 @@ int getTransposition(uint64_t b) {
 void putTransposition(uint64_t b, int value) {
     uint64_t hash = getHash(b);
     int hashIndex = ((int) hash & HASHMASK);
+    STAT_STORE(hashTable[hashIndex].key, b);
     hashTable[hashIndex].key = b;
     hashTable[hashIndex].value = value;
 }
@@ -341,14 +634,64 @@ void generateMoves(uint64_t b, uint64_t *const allmv) {// Generate all possible
     }
 }
 
+/*
+ * Number of different move codes. A move is coded as 64 * (index of the direction) + (bit of the destination hole)
+ */
+#define NUMMOVECODES 256
+
+/*
+ * Upper bound for the number of moves in one game (every move removes one peg)
+ */
+#define MAXGAMELENGTH 64
+
+/*
+ * Write all possible moves for a board b as move codes into the list moves (in the order of generateMoves())
+ * and return the number of moves.
+ */
+int listMoves(uint64_t b, int *const moves) {
+    uint64_t allmv[8];
+    int n = 0;
+    generateMoves(b, allmv);
+    for (int i = 0; i < 8; i++) {
+        uint64_t mv = allmv[i];
+        while (mv != ZERO) {
+            uint64_t x = ((mv - UINT64_C(1)) ^ mv) & mv;
+            moves[n++] = 64 * (i & 3) + bitPos(x);
+            mv &= (mv - 1);
+        }
+    }
+    return n;
+}
+
+/*
+ * Perform the move with the code m on board b and return the new board
+ */
+uint64_t doMove(uint64_t b, int m) {
+    int dir = DIRECTIONS[m >> 6];
+    uint64_t x = UINT64_C(1) << (m & 63);
+    b |= x; // set peg at new position
+    b &= ~rol(x, -dir); // remove jumped-over peg
+    b &= ~rol(x, -2 * dir); // remove  peg from old position
+    return b;
+}
+
 
 int backtrack(uint64_t b);
+int calibrationSearch(uint64_t b);
+
+// Counters of the calibration search of estimate(): visits and table hits per number of pegs, and the number of
+// nodes. When calibrationNodes reaches calibrationLimit, the search jumps back to calibrationAbort.
+static uint64_t calibrationVisits[MAXGAMELENGTH];
+static uint64_t calibrationHits[MAXGAMELENGTH];
+static uint64_t calibrationNodes = 0;
+static uint64_t calibrationLimit = 0;
+static jmp_buf calibrationAbort;
 
 /*
  * Try all moves coded in mv (contains the destination holes) for a board b in a direction dir. Return, if a terminal
- * position is reached.
+ * position is reached. The calibration search does not print the solution.
  */
-int tryMoves(uint64_t b, uint64_t mv, int dir) {
+static inline __attribute__((always_inline)) int tryMoves(uint64_t b, uint64_t mv, int dir, const int calibrating) {
     while (mv != ZERO) {
         uint64_t x = ((mv - UINT64_C(1)) ^ mv) & mv;
 
@@ -358,7 +701,7 @@ int tryMoves(uint64_t b, uint64_t mv, int dir) {
         b &= ~rol(x, -2 * dir); // remove  peg from old position
 
         //recursion
-        int res = backtrack(b);
+        int res = calibrating ? calibrationSearch(b) : backtrack(b);
 
         // undo move
         b &= ~x; // remove peg from new position again
@@ -369,8 +712,10 @@ int tryMoves(uint64_t b, uint64_t mv, int dir) {
         mv &= (mv - 1); // remove this move from the list
 
         if (res > 0 && res <= TERM_CRITERION) {
-            printf("Move: %d, %d", dir, bitPos(x));
-            printBoard(b);
+            if (!calibrating) {
+                printf("Move: %d, %d", dir, bitPos(x));
+                printBoard(b);
+            }
             return res;
         }
 
@@ -379,15 +724,27 @@ int tryMoves(uint64_t b, uint64_t mv, int dir) {
 }
 
 /*
- * Backtracking function to solve the board. It investigates all moves in the 4 possible directions. It randomly
- * selects the first direction to enforce different searching order in case the solver is started several times.
- * The possible moves for one position can be found very fast with only a dew bitwise operations.
+ * Search of backtrack() and calibrationSearch(). Both are compiled from this function with a constant value of
+ * calibrating, so that the counters of the calibration do not cost anything in the normal search.
  */
-int backtrack(uint64_t b) {
+static inline __attribute__((always_inline)) int searchPosition(uint64_t b, const int calibrating) {
+#ifdef SEARCH_STATS
+    int pegs = popCount(b);
+    STAT_NODE(pegs);
+#endif
+    if (calibrating) {
+        calibrationVisits[bitCount(b)]++;
+        if (++calibrationNodes == calibrationLimit)
+            longjmp(calibrationAbort, 1);
+    }
+
     // first check transposition table for this particular position
     int value = getTransposition(b);
-    if (value != HASHMISS)
+    if (value != HASHMISS) {
+        if (calibrating)
+            calibrationHits[bitCount(b)]++;
         return value;
+    }
 
     // will contain all possible moves later. Indexes 0-3 will contain the most promising moves in all 4 directions,
     // and indexes 4-7 will contain the less promising moves in all directions
@@ -397,6 +754,7 @@ int backtrack(uint64_t b) {
 
     // Find all possible moves, sorted according to some characteristics
     generateMoves(b, allmv);
+    STAT_EXPAND(pegs, allmv);
 
 
     uint64_t mv;
@@ -406,7 +764,7 @@ int backtrack(uint64_t b) {
         mv = allmv[i];
         dir = DIRECTIONS[i & 3]; // = i % 4
         if (mv != ZERO) {
-            res = tryMoves(b, mv, dir);
+            res = tryMoves(b, mv, dir, calibrating);
             if (res > 0 && res <= TERM_CRITERION) {
                 // Not neccessary to put position in transposition table
                 return res;
@@ -425,6 +783,22 @@ int backtrack(uint64_t b) {
 
 }
 
+/*
+ * Backtracking function to solve the board. It investigates all moves in the 4 possible directions. It randomly
+ * selects the first direction to enforce different searching order in case the solver is started several times.
+ * The possible moves for one position can be found very fast with only a dew bitwise operations.
+ */
+int backtrack(uint64_t b) {
+    return searchPosition(b, 0);
+}
+
+/*
+ * Same search as backtrack(), which counts its nodes for estimate() and stops after calibrationLimit nodes
+ */
+int calibrationSearch(uint64_t b) {
+    return searchPosition(b, 1);
+}
+
 
 /*
  * Root-node of the solver. Initializes the board and all other necessary variables
@@ -437,18 +811,723 @@ void solve() {
     uint64_t b = BOARD;
     b = removePeg(b, 57); // remove one peg
 
-    // Start back-tracking
+    // Start back-tracking. The reporter thread prints the search statistics periodically (if compiled in).
+    STATS_REGISTER(b);
+    STATS_START();
     backtrack(b);
+    STATS_STOP();
 }
 
-int main() {
+/*
+ * Anytime search for large boards: Nested Rollout Policy Adaptation (NRPA). Random games (rollouts) are played
+ * according to a policy, which assigns a weight to every move code. On each level, the policy is adapted towards
+ * the best sequence found so far by the level below. Several threads run independent NRPA searches in parallel,
+ * each with its own random number generator, and share the best sequence that was found by any of them.
+ */
+
+// Nesting level of a search and number of iterations per level. The number of rollouts is NRPA_ITERATIONS^level.
+#define NRPA_LEVEL 3
+#define NRPA_ITERATIONS 100
+
+// Learning rate for adapting the policy
+#define NRPA_ALPHA 1.0
+
+// Maximum number of search threads
+#define NRPA_MAXTHREADS 64
+
+// One move sequence and the number of pegs left after playing it
+struct Rollout {
+    int pegs;
+    int length;
+    int moves[MAXGAMELENGTH];
+};
+
+struct NrpaThread {
+    pthread_t thread;
+    uint64_t root;
+    int level;
+    uint64_t rng;
+};
+
+// Number of pegs of a rollout that has not been played yet (worse than any real result)
+#define NRPA_NOROLLOUT 99
+
+// Best sequence found by all threads so far. It is only written while holding nrpaLock, and pegs is written
+// last with an atomic store, so that it can be compared without the lock.
+static struct Rollout nrpaBest = {.pegs = NRPA_NOROLLOUT, .length = 0};
+static pthread_mutex_t nrpaLock = PTHREAD_MUTEX_INITIALIZER;
+static int nrpaStop = 0;
+static double nrpaStart = 0.0;
+
+/*
+ * xorshift64* random number generator. Every thread has its own state s, which must not be zero.
+ */
+static inline uint64_t nextRandom(uint64_t *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * UINT64_C(0x2545F4914F6CDD1D);
+}
+
+/*
+ * Random number in [0, 1)
+ */
+static inline double randomUnit(uint64_t *s) {
+    return (double) (nextRandom(s) >> 11) * 0x1p-53;
+}
+
+/*
+ * Compare a rollout with the best sequence of all threads and replace it, if it leaves fewer pegs.
+ * Every improvement is reported as a JSON line on stderr, including its moves as [direction, hole] pairs
+ * from the initial board, so that the best sequence is known at any moment.
+ */
+void offerRollout(const struct Rollout *r) {
+    if (r->pegs >= __atomic_load_n(&nrpaBest.pegs, __ATOMIC_RELAXED))
+        return;
+    pthread_mutex_lock(&nrpaLock);
+    if (r->pegs < nrpaBest.pegs) {
+        nrpaBest.length = r->length;
+        memcpy(nrpaBest.moves, r->moves, sizeof(r->moves[0]) * r->length);
+        __atomic_store_n(&nrpaBest.pegs, r->pegs, __ATOMIC_RELEASE);
+        fprintf(stderr, "{\"time\":%.3f,\"bestPegsLeft\":%d,\"moves\":[", wallTime() - nrpaStart, r->pegs);
+        for (int k = 0; k < r->length; k++)
+            fprintf(stderr, "%s[%d,%d]", k ? "," : "", DIRECTIONS[r->moves[k] >> 6], r->moves[k] & 63);
+        fprintf(stderr, "]}\n");
+        fflush(stderr);
+        if (r->pegs <= TERM_CRITERION)
+            __atomic_store_n(&nrpaStop, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&nrpaLock);
+}
+
+/*
+ * Play one random game from board b. Each move is selected with a probability proportional to exp(policy[move]).
+ */
+void playout(uint64_t b, const double *const policy, uint64_t *rng, struct Rollout *r) {
+    int moves[NUMMOVECODES];
+    double weights[NUMMOVECODES];
+    r->length = 0;
+    for (;;) {
+        STAT_NODE(bitCount(b));
+        int n = listMoves(b, moves);
+        if (n == 0)
+            break;
+        double z = 0.0;
+        for (int i = 0; i < n; i++) {
+            weights[i] = exp(policy[moves[i]]);
+            z += weights[i];
+        }
+        double u = randomUnit(rng) * z;
+        int k = 0;
+        while (k < n - 1 && (u -= weights[k]) >= 0.0)
+            k++;
+        r->moves[r->length++] = moves[k];
+        b = doMove(b, moves[k]);
+    }
+    r->pegs = bitCount(b);
+}
+
+/*
+ * Shift the policy towards the moves of the sequence best, which starts at board b
+ */
+void adaptPolicy(uint64_t b, double *const policy, const struct Rollout *best) {
+    double old[NUMMOVECODES];
+    int moves[NUMMOVECODES];
+    memcpy(old, policy, sizeof(old));
+    for (int k = 0; k < best->length; k++) {
+        int n = listMoves(b, moves);
+        double z = 0.0;
+        for (int i = 0; i < n; i++)
+            z += exp(old[moves[i]]);
+        policy[best->moves[k]] += NRPA_ALPHA;
+        for (int i = 0; i < n; i++)
+            policy[moves[i]] -= NRPA_ALPHA * exp(old[moves[i]]) / z;
+        b = doMove(b, best->moves[k]);
+    }
+}
+
+/*
+ * Nested rollout policy adaptation for board b. Returns the best sequence of this level in best.
+ */
+void nrpa(uint64_t b, int level, const double *const policy, uint64_t *rng, struct Rollout *best) {
+    if (level == 0) {
+        playout(b, policy, rng, best);
+        offerRollout(best);
+        return;
+    }
+    double local[NUMMOVECODES];
+    memcpy(local, policy, sizeof(local));
+    best->pegs = NRPA_NOROLLOUT;
+    best->length = 0;
+    for (int i = 0; i < NRPA_ITERATIONS && !__atomic_load_n(&nrpaStop, __ATOMIC_RELAXED); i++) {
+        struct Rollout r;
+        nrpa(b, level - 1, local, rng, &r);
+        if (r.pegs <= best->pegs)
+            *best = r;
+        adaptPolicy(b, local, best);
+    }
+}
+
+/*
+ * Handler for SIGINT and SIGTERM: stops the search, so that the best sequence found so far is printed
+ */
+void nrpaInterrupt(int sig) {
+    (void) sig;
+    __atomic_store_n(&nrpaStop, 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * Search thread: starts new NRPA searches with an empty policy until the search is stopped
+ */
+void *nrpaThread(void *arg) {
+    struct NrpaThread *t = (struct NrpaThread *) arg;
+    double policy[NUMMOVECODES] = {0};
+    struct Rollout r;
+    STATS_REGISTER(t->root);
+    while (!__atomic_load_n(&nrpaStop, __ATOMIC_RELAXED))
+        nrpa(t->root, t->level, policy, &t->rng, &r);
+    return arg;
+}
+
+/*
+ * Anytime root of the solver. Searches with NRPA on all cores for at most seconds seconds (or until a solution
+ * is found or the program is interrupted) and prints the best move sequence found.
+ */
+void solveNrpa(double seconds, int level) {
+    // the transposition table is not needed, so it is not initialized
+    initBOARDBits();
+    initBoardnBoundary();
+    initCorners();
+    uint64_t b = BOARD;
+    b = removePeg(b, 57);
+
+    int numThreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (numThreads < 1)
+        numThreads = 1;
+    if (numThreads > NRPA_MAXTHREADS)
+        numThreads = NRPA_MAXTHREADS;
+    struct NrpaThread threads[NRPA_MAXTHREADS];
+
+    signal(SIGINT, nrpaInterrupt);
+    signal(SIGTERM, nrpaInterrupt);
+    nrpaStart = wallTime();
+    STATS_START();
+    for (int i = 0; i < numThreads; i++) {
+        threads[i].root = b;
+        threads[i].level = level;
+        // every thread gets its own generator, seeded from the generator initialized in main()
+        threads[i].rng = getHash(((uint64_t) rand() << 32) ^ (uint64_t) (i + 1)) | UINT64_C(1);
+        pthread_create(&threads[i].thread, NULL, nrpaThread, &threads[i]);
+    }
+    while (!__atomic_load_n(&nrpaStop, __ATOMIC_RELAXED) && wallTime() - nrpaStart < seconds)
+        usleep(10000);
+    __atomic_store_n(&nrpaStop, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < numThreads; i++)
+        pthread_join(threads[i].thread, NULL);
+    STATS_STOP();
+
+    // print the best sequence, starting from the initial board
+    if (nrpaBest.pegs == NRPA_NOROLLOUT) {
+        printf("\nNo sequence found within the time limit\n");
+        return;
+    }
+    printf("\nBest sequence leaves %d pegs:\n", nrpaBest.pegs);
+    for (int k = 0; k < nrpaBest.length; k++) {
+        int m = nrpaBest.moves[k];
+        printBoard(b);
+        printf("Move: %d, %d\n", DIRECTIONS[m >> 6], m & 63);
+        b = doMove(b, m);
+    }
+    printBoard(b);
+}
+
+/*
+ * Estimation of the size of the search tree (and thereby the run-time of solve()) for a position, without
+ * searching it. Random root-to-leaf probes are combined with Knuth's estimator: on a probe that sees n_0, n_1, ...
+ * moves on its way down, the tree has about 1 + n_0 + n_0 * n_1 + ... nodes. The transposition table cuts off
+ * positions that were already searched: a position with d parents is visited d times, but expanded only once.
+ * So on every step of a probe the number of expanded positions is divided by the number of parents of the
+ * position, that can be reached from the root. The levels are bounded by the number of different boards with
+ * this number of pegs and the table hit rates of the real search. These hit rates and the speed are measured
+ * with calibrationSearch(), the search of backtrack() with a node budget, from the root and from random positions
+ * on every depth of the tree.
+ * This is the size of the exhaustive search. A position with a solution is only searched until the first one,
+ * which often takes far less (about 1e9 instead of more than 1e12 nodes for the initial board). Random probes practically
+ * never reach a solution (not one in 10 million random games from the initial board), so they can't tell when
+ * this happens, and the exhaustive estimate is only an upper bound for such positions.
+ * The probes are distributed evenly over the moves of the root, which gives an estimate per root move.
+ */
+
+// Default number of random probes
+#define ESTIMATE_PROBES 300
+
+// Number of moves above the parent of a position, in which the probes search for its other parents. Further up,
+// only the parents are found that differ by one move of the probe, which does not share a hole with the later
+// moves. Other transpositions of moves further apart are missed, this makes the estimate somewhat too high.
+#define ESTIMATE_ANCESTORS 8
+
+// Size of the table of the positions seen while counting the parents of a position (as power of 2)
+#define ESTIMATE_PARENTBITS 18
+
+// Node budget of the search from the root. If it finishes within this budget, its node count is exact.
+#define ESTIMATE_ROOTBUDGET (1 << 21)
+
+// Number of random positions per depth from which the search is run, and the node budget of each run
+#define ESTIMATE_SAMPLES 32
+#define ESTIMATE_SAMPLEBUDGET (1 << 13)
+
+// Minimum number of visits of a peg count before its measured hit rate is used
+#define ESTIMATE_MINVISITS 32
+
+/*
+ * Search board b until it is finished or has searched budget nodes. Returns the result of the search like
+ * backtrack(), or HASHMISS, if it was interrupted.
+ */
+int calibrate(uint64_t b, uint64_t budget) {
+    calibrationLimit = calibrationNodes + budget;
+    if (setjmp(calibrationAbort) != 0) {
+        // The search was interrupted. The table is still consistent, since entries are only written for
+        // positions that were searched completely.
+        return HASHMISS;
+    }
+    return calibrationSearch(b);
+}
+
+/*
+ * Play depth random moves from board b. Returns 0, if the game ends before.
+ */
+uint64_t randomPosition(uint64_t b, int depth, uint64_t *rng) {
+    int moves[NUMMOVECODES];
+    for (int i = 0; i < depth; i++) {
+        int n = listMoves(b, moves);
+        if (n == 0)
+            return ZERO;
+        int k = (int) (randomUnit(rng) * n);
+        b = doMove(b, moves[k < n ? k : n - 1]);
+    }
+    return b;
+}
+
+static uint64_t parentBoards[1 << ESTIMATE_PARENTBITS];
+static uint32_t parentStamps[1 << ESTIMATE_PARENTBITS];
+static uint32_t parentStamp = 0;
+static int parentSize = 0;
+
+/*
+ * Mark board b as seen in the current count of parents. Returns 0, if it was seen before. If the table is
+ * almost full, all further boards count as seen.
+ */
+int markParentSearch(uint64_t b) {
+    uint32_t mask = (1 << ESTIMATE_PARENTBITS) - 1;
+    uint32_t i = (uint32_t) getHash(b) & mask;
+    while (parentStamps[i] == parentStamp) {
+        if (parentBoards[i] == b)
+            return 0;
+        i = (i + 1) & mask;
+    }
+    if (parentSize >= (1 << ESTIMATE_PARENTBITS) / 4 * 3)
+        return 0;
+    parentStamps[i] = parentStamp;
+    parentBoards[i] = b;
+    parentSize++;
+    return 1;
+}
+
+/*
+ * Return 1, if board b was seen in the current count of parents
+ */
+int isParentSeen(uint64_t b) {
+    uint32_t mask = (1 << ESTIMATE_PARENTBITS) - 1;
+    uint32_t i = (uint32_t) getHash(b) & mask;
+    while (parentStamps[i] == parentStamp) {
+        if (parentBoards[i] == b)
+            return 1;
+        i = (i + 1) & mask;
+    }
+    return 0;
+}
+
+/*
+ * Return 1, if board c follows from board b by one move
+ */
+int isMove(uint64_t b, uint64_t c) {
+    uint64_t d = b ^ c;
+    uint64_t x = d & c; // destination hole of the move
+    if (bitCount(d) != 3 || bitCount(x) != 1)
+        return 0;
+    for (int i = 0; i < 4; i++) {
+        if (d == (x | rol(x, -DIRECTIONS[i]) | rol(x, -2 * DIRECTIONS[i])))
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ * Count the different parents of board c, that can be reached from board b in depth moves. Every board is
+ * searched only once.
+ */
+int countParents(uint64_t b, uint64_t c, int depth) {
+    if (!markParentSearch(b))
+        return 0;
+    if (depth == 0)
+        return isMove(b, c);
+    // every move changes 3 holes, so b can't reach c if they differ in too many
+    if (bitCount(b ^ c) > 3 * (depth + 1))
+        return 0;
+    int moves[NUMMOVECODES];
+    int n = listMoves(b, moves);
+    int parents = 0;
+    for (int i = 0; i < n; i++)
+        parents += countParents(doMove(b, moves[i]), c, depth - 1);
+    return parents;
+}
+
+/*
+ * Number of parents of board c, where path contains the len positions of the probe that leads to c.
+ * All parents are found, that can be reached from the last ESTIMATE_ANCESTORS positions before the parent.
+ * A move of the probe further up can be played last instead, if none of the later moves uses one of its holes.
+ * Undoing it gives another parent, that can be reached from the root.
+ */
+int inDegree(uint64_t c, const uint64_t *const path, int len) {
+    int depth = len - 1 < ESTIMATE_ANCESTORS ? len - 1 : ESTIMATE_ANCESTORS;
+    parentStamp++;
+    parentSize = 0;
+    int parents = countParents(path[len - 1 - depth], c, depth);
+    uint64_t later = path[len - 1] ^ c; // holes changed by the moves after move i
+    for (int i = len - 2; i >= 0; i--) {
+        uint64_t holes = path[i] ^ path[i + 1];
+        if (i < len - 1 - depth && (holes & later) == ZERO && !isParentSeen(c ^ holes))
+            parents++;
+        later |= holes;
+    }
+    return parents > 0 ? parents : 1;
+}
+
+/*
+ * One random probe from board b to a leaf, where path contains the len positions above b. Adds the expected
+ * number of visits per number of pegs to levelNodes, and the size of the tree without transpositions to treeSize.
+ * Returns the expected number of visits of this probe.
+ */
+double probe(uint64_t b, uint64_t *const path, int len, uint64_t *rng, double *const levelNodes, double *treeSize) {
+    int moves[NUMMOVECODES];
+    double visits = 1.0, expanded = 1.0, width = 1.0, nodes = 0.0;
+    for (;;) {
+        levelNodes[bitCount(b)] += visits;
+        nodes += visits;
+        *treeSize += width;
+        int n = listMoves(b, moves);
+        if (n == 0)
+            break;
+        width *= n;
+        int k = (int) (randomUnit(rng) * n);
+        path[len++] = b;
+        b = doMove(b, moves[k < n ? k : n - 1]);
+        visits = expanded * n;
+        expanded = visits / inDegree(b, path, len);
+    }
+    return nodes;
+}
+
+/*
+ * Combine the probes of one subtree. Since each position is expanded at most once, the nodes with p pegs are
+ * bounded by the number of boards with p pegs (divided by the fraction of visits that are no table hits).
+ */
+double subtreeNodes(const double *const levelNodes, int numProbes, const double *const maxNodes) {
+    double nodes = 0.0;
+    for (int i = 0; i < MAXGAMELENGTH; i++) {
+        double levelMean = levelNodes[i] / numProbes;
+        nodes += levelMean < maxNodes[i] ? levelMean : maxNodes[i];
+    }
+    return nodes;
+}
+
+/*
+ * Mirror a board along the diagonal from the top left to the bottom right. This is a symmetry of the board as
+ * well, but the transposition table does not use it.
+ */
+uint64_t mirrorDiag(uint64_t b) {
+    // row r has its holes in the columns abs(4 - r) ... 8 - abs(4 - r), first[r] is the index of the first one
+    int first[NUMROWS + 1];
+    first[0] = 0;
+    for (int r = 0; r < NUMROWS; r++)
+        first[r + 1] = first[r] + NUMROWS - 2 * abs(NUMROWS / 2 - r);
+    uint64_t m = ZERO;
+    for (int r = 0; r < NUMROWS; r++) {
+        int start = abs(NUMROWS / 2 - r);
+        for (int c = start; c < NUMROWS - start; c++) {
+            if (b & (UINT64_C(1) << BOARDBITS[first[r] + c - start]))
+                m |= UINT64_C(1) << BOARDBITS[first[c] + r - abs(NUMROWS / 2 - c)];
+        }
+    }
+    return m;
+}
+
+/*
+ * Estimate the number of nodes and the time that solve() needs for board b (0 for the initial board) and
+ * print the result, including the estimates for the subtrees of all root moves, as JSON to stdout.
+ * If the calibration finishes the search, the node counts are exact and include the stop at the first solution.
+ * Otherwise the expected values are the estimates of the exhaustive search. Returns 0 on success.
+ */
+int estimate(int numProbes, uint64_t b) {
+    init();
+    if (b == ZERO)
+        b = removePeg(BOARD, 57);
+    if ((b & ~BOARD) != ZERO) {
+        fprintf(stderr, "The board contains holes outside of the Diamond-41 board\n");
+        return 1;
+    }
+    STATS_REGISTER(b);
+    uint64_t rng = getHash((uint64_t) rand()) | UINT64_C(1);
+    int moves[NUMMOVECODES];
+    int n = listMoves(b, moves);
+
+    // A root move, whose board is a mirror image of the board of an earlier root move, is a table hit in the
+    // search, since its subtree was already searched as the mirror image of the earlier one. If it is only an
+    // image under the other symmetries of the board, its subtree is searched, but has the same size.
+    int mirrorOf[NUMMOVECODES], symmetricTo[NUMMOVECODES], hasMirror[NUMMOVECODES] = {0};
+    for (int i = 0; i < n; i++) {
+        uint64_t m[2 * NUMSYMMETRIES];
+        mirror(doMove(b, moves[i]), m);
+        mirror(mirrorDiag(m[0]), m + NUMSYMMETRIES);
+        mirrorOf[i] = symmetricTo[i] = -1;
+        for (int j = 0; j < i && mirrorOf[i] < 0; j++) {
+            uint64_t earlier = doMove(b, moves[j]);
+            for (int k = 1; k < 2 * NUMSYMMETRIES; k++) {
+                if (m[k] == earlier && k < NUMSYMMETRIES) {
+                    mirrorOf[i] = j;
+                    hasMirror[j] = 1;
+                    break;
+                }
+                if (m[k] == earlier && symmetricTo[i] < 0 && mirrorOf[j] < 0)
+                    symmetricTo[i] = symmetricTo[j] < 0 ? j : symmetricTo[j];
+            }
+        }
+        if (mirrorOf[i] >= 0)
+            symmetricTo[i] = -1;
+    }
+
+    // Calibration with the real search from the root. It searches the root moves one after the other like
+    // backtrack() and stops at the first solution, so that the nodes per root move are exact, if it finishes.
+    // Only this part measures the speed, since the samples below start from cold positions.
+    double start = wallTime();
+    uint64_t childSearched[NUMMOVECODES] = {0};
+    calibrationNodes++; // the root
+    calibrationVisits[bitCount(b)]++;
+    int complete = 1, solved = 0;
+    for (int i = 0; i < n && complete && !solved; i++) {
+        uint64_t before = calibrationNodes;
+        int value = calibrationNodes < ESTIMATE_ROOTBUDGET ?
+                    calibrate(doMove(b, moves[i]), ESTIMATE_ROOTBUDGET - calibrationNodes) : HASHMISS;
+        childSearched[i] = calibrationNodes - before;
+        if (value == HASHMISS)
+            complete = 0;
+        else if (value > 0 && value <= TERM_CRITERION)
+            solved = 1;
+    }
+    double elapsed = wallTime() - start;
+    uint64_t searched = calibrationNodes;
+    double nodesPerSec = elapsed > 0.0 ? (double) searched / elapsed : 0.0;
+    uint64_t rootVisits[MAXGAMELENGTH], rootHits[MAXGAMELENGTH];
+    memcpy(rootVisits, calibrationVisits, sizeof(rootVisits));
+    memcpy(rootHits, calibrationHits, sizeof(rootHits));
+    for (int depth = 1; !complete && depth < bitCount(b); depth++) {
+        for (int i = 0; i < ESTIMATE_SAMPLES; i++) {
+            uint64_t sample = randomPosition(b, depth, &rng);
+            if (sample != ZERO)
+                calibrate(sample, ESTIMATE_SAMPLEBUDGET);
+        }
+    }
+
+    // Hit rates per number of pegs. The search from the root is the most faithful measurement, the samples
+    // are only used for peg counts it did not reach often enough. A peg count with too few visits in both gets
+    // the rate of the nearest measured one.
+    double hitRate[MAXGAMELENGTH] = {0};
+    int measured[MAXGAMELENGTH] = {0};
+    for (int i = 0; i < MAXGAMELENGTH; i++) {
+        uint64_t visits = rootVisits[i], hits = rootHits[i];
+        if (visits < ESTIMATE_MINVISITS) {
+            visits = calibrationVisits[i] - rootVisits[i];
+            hits = calibrationHits[i] - rootHits[i];
+        }
+        if (visits >= ESTIMATE_MINVISITS) {
+            hitRate[i] = (double) hits / (double) visits;
+            measured[i] = 1;
+        }
+    }
+    for (int i = 0; i < MAXGAMELENGTH; i++) {
+        for (int d = 1; !measured[i] && d < MAXGAMELENGTH; d++) {
+            if (i - d >= 0 && measured[i - d]) {
+                hitRate[i] = hitRate[i - d];
+                break;
+            }
+            if (i + d < MAXGAMELENGTH && measured[i + d]) {
+                hitRate[i] = hitRate[i + d];
+                break;
+            }
+        }
+    }
+
+    // Upper bound for the nodes with a certain number of pegs: (41 choose pegs) / (1 - hit rate)
+    double maxNodes[MAXGAMELENGTH], boards = 1.0;
+    for (int i = 0; i < MAXGAMELENGTH; i++) {
+        maxNodes[i] = hitRate[i] < 1.0 ? boards / (1.0 - hitRate[i]) : boards;
+        boards = i < NUMBOARDBITS ? boards * (NUMBOARDBITS - i) / (i + 1) : 0.0;
+    }
+
+    // Probes, evenly distributed over the root moves without the mirror images. The subtree of a root move with
+    // mirror images is completely searched under this move, so its parents through the other root moves are not
+    // counted for it.
+    int distinct = 0;
+    for (int i = 0; i < n; i++)
+        distinct += mirrorOf[i] < 0;
+    int probesPerChild = distinct > 0 ? (numProbes + distinct - 1) / distinct : 0;
+    if (probesPerChild < 1)
+        probesPerChild = 1;
+    double childNodes[NUMMOVECODES];
+    double nodes = 1.0, tree = 1.0, variance = 0.0;
+    for (int i = 0; i < n; i++) {
+        childNodes[i] = 1.0;
+        if (mirrorOf[i] >= 0)
+            continue;
+        double levelNodes[MAXGAMELENGTH] = {0}, sumTree = 0.0, sum = 0.0, sumSquares = 0.0;
+        uint64_t path[MAXGAMELENGTH + 1] = {b};
+        for (int k = 0; k < probesPerChild; k++) {
+            double x = probe(doMove(b, moves[i]), path, hasMirror[i] ? 0 : 1, &rng, levelNodes, &sumTree);
+            sum += x;
+            sumSquares += x * x;
+        }
+        childNodes[i] = subtreeNodes(levelNodes, probesPerChild, maxNodes);
+        // variance of the mean of the probes
+        if (probesPerChild > 1) {
+            double mean = sum / probesPerChild;
+            double v = (sumSquares / probesPerChild - mean * mean) / (probesPerChild - 1);
+            variance += v > 0.0 ? v : 0.0;
+        }
+        tree += sumTree / probesPerChild;
+    }
+    // Symmetric root moves get the mean of their estimates
+    for (int i = 0; i < n; i++) {
+        if (mirrorOf[i] >= 0 || symmetricTo[i] >= 0)
+            continue;
+        double sum = childNodes[i];
+        int count = 1;
+        for (int j = i + 1; j < n; j++) {
+            if (symmetricTo[j] == i) {
+                sum += childNodes[j];
+                count++;
+            }
+        }
+        for (int j = i; j < n; j++) {
+            if (j == i || symmetricTo[j] == i)
+                childNodes[j] = sum / count;
+        }
+    }
+    for (int i = 0; i < n; i++)
+        nodes += childNodes[i];
+
+    // 95% confidence interval of the exhaustive search. It needs at least the nodes of the calibration, which
+    // did not find a solution, if it did not finish.
+    double exhaustive = nodes, low = nodes - 1.96 * sqrt(variance), high = nodes + 1.96 * sqrt(variance);
+    if (complete && !solved)
+        exhaustive = low = high = (double) searched;
+    if (low < (double) searched)
+        low = (double) searched;
+    // If the calibration run already finished the search, the node counts are exact
+    if (complete) {
+        nodes = (double) searched;
+        for (int i = 0; i < n; i++)
+            childNodes[i] = (double) childSearched[i];
+    }
+
+    printf("{\"board\":\"0x%016" PRIx64 "\",\"pegs\":%d,\"probes\":%d,\"exact\":%s,\"solved\":%s", b, bitCount(b),
+           probesPerChild * distinct, complete ? "true" : "false", solved ? "true" : "false");
+    printf(",\"calibrationNodes\":%" PRIu64 ",\"nodesPerSec\":%.0f,\"hitRate\":[", searched, nodesPerSec);
+    for (int i = 0; i <= NUMBOARDBITS; i++)
+        printf("%s%.4f", i ? "," : "", hitRate[i]);
+    printf("],\"treeNodes\":%.4g", tree);
+    // Exact node counts are printed with all digits. The exhaustive search is an upper bound: the search stops as
+    // soon as it finds a solution.
+    int digits = complete ? 10 : 4, exhaustiveDigits = complete && !solved ? 10 : 4;
+    printf(",\"exhaustiveNodes\":%.*g,\"exhaustiveNodesLow\":%.*g,\"exhaustiveNodesHigh\":%.*g", exhaustiveDigits,
+           exhaustive, exhaustiveDigits, low, exhaustiveDigits, high);
+    printf(",\"exhaustiveSeconds\":%.4g", nodesPerSec > 0.0 ? exhaustive / nodesPerSec : 0.0);
+    printf(",\"expectedNodes\":%.*g,\"expectedSeconds\":%.4g,\"children\":[", digits, nodes,
+           nodesPerSec > 0.0 ? nodes / nodesPerSec : 0.0);
+    for (int i = 0; i < n; i++) {
+        printf("%s{\"move\":[%d,%d],\"board\":\"0x%016" PRIx64 "\"", i ? "," : "", DIRECTIONS[moves[i] >> 6],
+               moves[i] & 63, doMove(b, moves[i]));
+        if (mirrorOf[i] >= 0)
+            printf(",\"mirrorOf\":%d", mirrorOf[i]);
+        if (symmetricTo[i] >= 0)
+            printf(",\"symmetricTo\":%d", symmetricTo[i]);
+        printf(",\"expectedNodes\":%.*g,\"share\":%.4f}", digits, childNodes[i],
+               nodes > 1.0 ? childNodes[i] / (nodes - 1.0) : 0.0);
+    }
+    printf("]}\n");
+    return 0;
+}
+
+/*
+ * Usage: solitaire_diamond                              exhaustive search
+ *        solitaire_diamond nrpa <seconds> [level]        anytime NRPA search with a time budget
+ *        solitaire_diamond estimate [probes] [board]     estimate the size of the exhaustive search
+ */
+int main(int argc, char *argv[]) {
+    int useNrpa = argc >= 3 && argc <= 4 && strcmp(argv[1], "nrpa") == 0;
+    double seconds = 0.0;
+    long level = NRPA_LEVEL;
+    if (useNrpa) {
+        char *end;
+        seconds = strtod(argv[2], &end);
+        if (*end != '\0' || !(seconds > 0.0)) {
+            fprintf(stderr, "Invalid number of seconds: %s\n", argv[2]);
+            return 1;
+        }
+        if (argc == 4) {
+            level = strtol(argv[3], &end, 10);
+            if (*end != '\0' || level < 1 || level > MAXGAMELENGTH) {
+                fprintf(stderr, "Invalid level: %s\n", argv[3]);
+                return 1;
+            }
+        }
+    }
+    int useEstimate = argc >= 2 && argc <= 4 && strcmp(argv[1], "estimate") == 0;
+    if (argc > 1 && !useNrpa && !useEstimate) {
+        fprintf(stderr, "Usage: %s [nrpa <seconds> [level] | estimate [probes] [board as hex]]\n", argv[0]);
+        return 1;
+    }
+    if (useEstimate) {
+        // only JSON on stdout, so that the result can be read by a scheduler
+        char *end;
+        long probes = ESTIMATE_PROBES;
+        if (argc >= 3) {
+            probes = strtol(argv[2], &end, 10);
+            if (*end != '\0' || probes < 1 || probes > INT32_MAX) {
+                fprintf(stderr, "Invalid number of probes: %s\n", argv[2]);
+                return 1;
+            }
+        }
+        uint64_t b = ZERO; // initial board
+        if (argc >= 4) {
+            b = strtoull(argv[3], &end, 16);
+            if (*end != '\0' || end == argv[3] || argv[3][0] == '-' || b == ZERO) {
+                fprintf(stderr, "Invalid board: %s\n", argv[3]);
+                return 1;
+            }
+        }
+        srand(time(NULL));
+        return estimate((int) probes, b);
+    }
     printf("Lets start solving the Diamond-41 peg solitaire problem...");
     fflush(stdout);
     time_t start, end;
     double elapsed;  // seconds
     start = time(NULL);
     srand(start); // initialize random generator
-    solve();
+    if (useNrpa)
+        solveNrpa(seconds, (int) level);
+    else
+        solve();
     end = time(NULL);
     elapsed = difftime(end, start);
 